@@ -18,11 +18,13 @@
 #include "mutex_lock.hpp"
 
 #include "mailbox_map_types.hpp"
+#include "mailbox_link.hpp"
 
 #include <unordered_map>
 #include <array>
 
 #include "pico/mutex.h"
+#include "pico/rand.h"
 
 /*--------------------------------------------------------------------
                           GLOBAL NAMESPACES
@@ -44,11 +46,12 @@ enum struct msg_type /* message type (from un/pack engine)          */
     };
 struct msgAPI_rx /* receive message data mover                      */
 	{
-    msgAPI_rx( msg_type rtn, mbx_index idx, data_union data ) : r(rtn), i(idx), d(data) {}
+    msgAPI_rx( msg_type rtn, mbx_index idx, data_union data, uint8_t seq = 0 ) : r(rtn), i(idx), d(data), s(seq) {}
     msgAPI_rx() {} 
 	msg_type r;   /* message type                                   */
 	mbx_index i;  /* message mailbox ptr                            */
 	data_union d; /* message data variable                          */
+	uint8_t s;    /* message sequence byte (data/ack only)          */
 	};
 
 struct msgAPI_tx /* transmit data request mover                     */
@@ -78,6 +81,9 @@ enum mailbox_error_types               /* error bit array defines   */
                                           engine                    */
     RX_MSG_OVERFLOW   = ( 0x01 << 7 ), /* message overflow in RX
                                           runtime                   */
+    RX_VERSION_MISMATCH = ( 0x01 << 8 ), /* protocol header missing
+                                          or version mismatch in RX
+                                          runtime                   */
     };
 
 /*--------------------------------------------------------------------
@@ -137,6 +143,7 @@ class mailbox
         void rx_runtime( void );                                /* rx_runtime    */
         void tx_runtime( void );                                /* tx_runtime    */
         void watchdog( void );                                  /* watchdog fn   */
+        mailbox_seq_stats sequence_stats( void );               /* seq stats     */
 
         data_union access( mbx_index global_mbx_indx, flag_type& current_flag, bool clear_flag = true ); /* mailbox data access */
         bool update( data_union d, int global_mbx_indx, bool user_mode = true );                         /* mailbox data update */
@@ -151,16 +158,19 @@ class mailbox
         utl::queue<(M+1), msgAPI_tx> p_transmit_queue; /* transmit queue                */
         utl::queue<M, mbx_index> p_ack_queue;          /* ack queue                     */
         std::array<bool, M> p_awaiting_ack;            /* awaiting ack list             */
+        mailbox_link<M> p_link;                        /* sequence & pending tx state   */
         utl::queue<M, msgAPI_rx> p_rx_queue;           /* receive queue                 */
         volatile int p_current_round;                  /* current round                 */
         mutex_t p_mailbox_protection;                  /* mailbox update mutex          */
         bool p_watchdog_pet;                           /* watchdog pet variable         */
-        uint8_t p_errors;                              /* error bit array               */
+        uint16_t p_errors;                             /* error bit array               */
 
         tx_message lora_pack_engine( void );           /* pack lora messages            */
         void lora_unpack_engine( const rx_multi msg ); /* unpack lora messages          */
         void process_tx( mbx_index index );            /* process tx data               */
         void process_rx_data( mbx_index index, data_union data ); /* process rx data    */
+        bool queue_tx( msgAPI_tx msg );                /* push to tx queue w/o dupes    */
+        data_union access_with_seq( mbx_index global_mbx_indx, flag_type& current_flag, uint8_t& seq_byte, bool clear_flag, bool advance_seq ); /* access w/ tx seq */
         void transmit_engine( void );                  /* transmit engine               */
         void log_error( mailbox_error_types err );     /* log error                     */
         mbx_index verify_index( int idx );             /* verify mailbox index validity */
@@ -30,20 +30,28 @@
 /*--------------------------------------------------------------------
                           LITERAL CONSTANTS
 --------------------------------------------------------------------*/
-#define MAX_SIZE_GLOBAL_MAILBOX ( 254  ) /* Max size of a global 
-											mailbox: 256 minus ack id
-											and update id 		   */
+#define MAX_SIZE_GLOBAL_MAILBOX ( 253  ) /* Max size of a global 
+											mailbox: 256 minus ack id,
+											update id & protocol id*/
 #define MSG_ACK_ID              ( 0xFF ) /* ACK identifier         */
 #define MSG_UPDATE_ID           ( 0xFE ) /* Round Update identifier
 																   */
+#define MSG_PROTOCOL_ID         ( 0xFD ) /* Protocol header 
+											identifier			   */
+#define MAILBOX_PROTOCOL_VERSION ( 2   ) /* wire format version, 
+											v2 adds sequence bytes */
+#define HEADER_BYTE_SIZE        ( 2    ) /* size of protocol header
+											[id][version]		   */
 
 #define RND_CNTR_ROLLOVER       ( 100  ) /* Round rollover value   */
 #define INDEX_BYTE_SIZE         ( 1    ) /* size of index byte in 
 											message				   */
+#define SEQ_BYTE_SIZE           ( 1    ) /* size of sequence byte
+											in data/ack message	   */
 
 #define TX_ERR_MASK				( 0x18 ) /* TX runtime error mask  */
-#define RX_ERR_MASK				( 0x0F ) /* RX runtime error mask  */
-#define ALL_ERR_MASK 			( 0xFF ) /* All error mask  	   */
+#define RX_ERR_MASK				( 0x10F) /* RX runtime error mask  */
+#define ALL_ERR_MASK 			( 0x1FF) /* All error mask  	   */
 /*--------------------------------------------------------------------
                                 TYPES
 --------------------------------------------------------------------*/
@@ -87,7 +95,8 @@ core::mailbox<M>::mailbox
 	(
 	std::array<mailbox_type, M>& global_mailbox 
 	) :
-	p_mailbox_ref( global_mailbox )
+	p_mailbox_ref( global_mailbox ),
+	p_link( static_cast<uint8_t>( get_rand_32() ) )
 {
 /*------------------------------------------------------
 Initilize current round and counter to zero. This is done 
@@ -174,10 +183,24 @@ for( msg_index = 0; msg_index < msg.num_messages; msg_index++ )
 		continue;
 		}
 
+	/*------------------------------------------------------
+	skip message if protocol header is missing or does not
+	match our version. All modules must run the same wire
+	format
+	------------------------------------------------------*/ 
+	if( rx_msg.size < HEADER_BYTE_SIZE                 ||
+		rx_msg.message[0] != MSG_PROTOCOL_ID           ||
+		rx_msg.message[1] != MAILBOX_PROTOCOL_VERSION     )
+		{
+		this->log_error(mailbox_error_types::RX_VERSION_MISMATCH);
+		continue;
+		}
+	msg_data_index = HEADER_BYTE_SIZE;
+
 	/*------------------------------------------------------
 	Parse through all packed messages within the single 
 	message. Data is packed in the following format:
-	[idx][data....][ack][idx][rnd][rnd]
+	[pid][ver][idx][seq][data....][ack][idx][seq][rnd][rnd]
 	------------------------------------------------------*/   
 	while( msg_data_index < rx_msg.size )
 		{
@@ -190,7 +213,7 @@ for( msg_index = 0; msg_index < msg.num_messages; msg_index++ )
 		/*------------------------------------------------------
 		Handle message if it is an ack
 
-		Format is [ACK_ID][Index]
+		Format is [ACK_ID][Index][Seq]
 		------------------------------------------------------*/
 		if( rx_msg.message[msg_data_index] == MSG_ACK_ID )
 			{
@@ -199,16 +222,25 @@ for( msg_index = 0; msg_index < msg.num_messages; msg_index++ )
 			--------------------------------------------------*/
 			msg_data_index++;
 
+			/*--------------------------------------------------
+			verify size of index & sequence bytes
+			--------------------------------------------------*/
+			if( msg_data_index + INDEX_BYTE_SIZE + SEQ_BYTE_SIZE > rx_msg.size )
+				{
+				this->log_error(mailbox_error_types::RX_MSG_OVERFLOW);
+				break;
+				}
+
 			/*--------------------------------------------------
 			Generate rx queue object for ack & add to queue
 			--------------------------------------------------*/
-			msgAPI_rx rx_data( msg_type::ack, this->verify_index(rx_msg.message[msg_data_index] ), data );
+			msgAPI_rx rx_data( msg_type::ack, this->verify_index(rx_msg.message[msg_data_index] ), data, rx_msg.message[msg_data_index + INDEX_BYTE_SIZE] );
 			p_rx_queue.push( rx_data );
 
 			/*--------------------------------------------------
 			Update pointer for processing
 			--------------------------------------------------*/
-			msg_data_index++;
+			msg_data_index += INDEX_BYTE_SIZE + SEQ_BYTE_SIZE;
 
 			}
 		/*------------------------------------------------------
@@ -239,7 +271,7 @@ for( msg_index = 0; msg_index < msg.num_messages; msg_index++ )
 		/*------------------------------------------------------
 		Handle message if it is actual data
 
-		Format is [Index][data...]
+		Format is [Index][Seq][data...]
 		------------------------------------------------------*/
 		else
 			{
@@ -281,13 +313,17 @@ for( msg_index = 0; msg_index < msg.num_messages; msg_index++ )
 			int data_size = itr->second;
 
 			/*------------------------------------------------------
-			verify size & memcpy data into union
+			verify size, aquire sequence number & memcpy data into
+			union
 			------------------------------------------------------*/
-			if (msg_data_index + data_size > rx_msg.size)
+			if (msg_data_index + SEQ_BYTE_SIZE + data_size > rx_msg.size)
 				{
 				this->log_error(mailbox_error_types::RX_MSG_OVERFLOW);
 				break; 
 				}
+			uint8_t seq = rx_msg.message[msg_data_index];
+			msg_data_index += SEQ_BYTE_SIZE;
+
 			memcpy( &data, &(rx_msg.message[msg_data_index]), data_size );
 
 			/*------------------------------------------------------
@@ -301,7 +337,7 @@ for( msg_index = 0; msg_index < msg.num_messages; msg_index++ )
 				/*--------------------------------------------------
 				Add data to queue
 				--------------------------------------------------*/
-				msgAPI_rx rx_data( msg_type::data, mailbox_index, data );
+				msgAPI_rx rx_data( msg_type::data, mailbox_index, data, seq );
 				p_rx_queue.push( rx_data );
 				}
 				
@@ -380,20 +416,31 @@ while( !p_rx_queue.is_empty() )
 		case msg_type::data:
 			{
 			/*------------------------------------------
-			Process (update) rx data
-			------------------------------------------*/	
-			this->process_rx_data( temp.i, temp.d );
+			Classify sequence byte. Stale data is 
+			dropped without an ack, p_link resyncs if 
+			the sender keeps repeating it. Changed data 
+			is never treated as a repeated reset frame
+			------------------------------------------*/
+			bool changed = memcmp( &temp.d, &p_mailbox_ref[ static_cast<int>(temp.i) ].data, sizeof(data_union) ) != 0;
+			seq_status status = p_link.receive( static_cast<int>(temp.i), temp.s, changed );
+
+			if( status == seq_status::stale )
+				break;
+
+			/*------------------------------------------
+			Process (update) rx data only if it is new.
+			Duplicates (retransmits due to a lost ack)
+			are re-acked but not re-flagged
+			------------------------------------------*/
+			if( status == seq_status::fresh )
+				this->process_rx_data( temp.i, temp.d );
 
 			/*------------------------------------------
 			Since we have rx'ed a index, add ack to tx
-			queue. If queue is full assert
+			queue. queue_tx() ensures a single ack per
+			index is pending and logs if queue is full
 			------------------------------------------*/	
-			msgAPI_tx tx_msg( msg_type::ack, temp.i );
-
-			if( !p_transmit_queue.push( tx_msg ) )
-				{
-				this->log_error(mailbox_error_types::QUEUE_FULL);
-				}
+			this->queue_tx( msgAPI_tx( msg_type::ack, temp.i ) );
 
 			break;
 			}
@@ -403,12 +450,28 @@ while( !p_rx_queue.is_empty() )
 		----------------------------------------------*/
 		case msg_type::ack:
 			{
+			/*------------------------------------------
+			Verify index is within mailbox
+			------------------------------------------*/
+			if( temp.i == mbx_index::MAILBOX_NONE )
+				{
+				this->log_error(mailbox_error_types::RX_INVALID_IDX);
+				break;
+				}
+
 			/*------------------------------------------
 			Reset p_awaiting_ack[] entry if ack was
-			expected, otherwise assert
+			expected and matches the sequence number in
+			flight. An ack for an older sequence number
+			does not confirm the current value, leave it
+			awaiting so it will be resent. Otherwise 
+			assert
 			------------------------------------------*/
 			if( p_awaiting_ack[ static_cast<uint8_t>(temp.i) ] )
-				p_awaiting_ack[ static_cast<uint8_t>(temp.i) ] = false;
+				{
+				if( p_link.ack( static_cast<int>(temp.i), temp.s ) )
+					p_awaiting_ack[ static_cast<uint8_t>(temp.i) ] = false;
+				}
 			else
 				this->log_error(mailbox_error_types::RX_UNEXPECTED_ACK);
 
@@ -543,12 +606,14 @@ while( !p_ack_queue.is_empty() )
 
 	/*--------------------------------------------------
 	If awaiting ack is not false this means we have 
-	missed an ack, if this is the case, resend data
+	missed an ack, if this is the case, resend data. The
+	resend carries the same sequence number unless the
+	entry has since been updated, so the receiver will
+	only re-ack it
 	--------------------------------------------------*/
 	if( p_awaiting_ack[static_cast<int>(current_index)] != false )
 		{
-		if( !p_transmit_queue.push( msgAPI_tx( msg_type::data, current_index ) ) )
-			this->log_error(mailbox_error_types::QUEUE_FULL);
+		this->queue_tx( msgAPI_tx( msg_type::data, current_index ) );
 		}
 
 	p_ack_queue.pop();
@@ -617,11 +682,24 @@ tripped. Exit if no flag
 if( current_mailbox.upt_rt == update_rate::RT_ASYNC && current_mailbox.flag == flag_type::NO_FLAG )
 	return;
 
+/*----------------------------------------------------------
+A scheduled periodic send is a new value even if unchanged,
+advance sequence number so receivers process (and flag) it.
+If the entry was written (TRANSMIT_FLAG) the pack engine 
+advances instead, see access_with_seq()
+----------------------------------------------------------*/
+if( current_mailbox.upt_rt != update_rate::RT_ASYNC )
+	{
+	utl::mutex_lock lock( p_mailbox_protection );
+
+	if( current_mailbox.flag != flag_type::TRANSMIT_FLAG )
+		p_link.advance( static_cast<int>(index) );
+	} /* release mutex */
+
 /*----------------------------------------------------------
 Add msgAPI_tx object to Tx queue
 ----------------------------------------------------------*/
-if( !p_transmit_queue.push( msg_tx ) )
-	this->log_error(mailbox_error_types::QUEUE_FULL);
+this->queue_tx( msg_tx );
 
 } /* core::mailbox<M>::process_tx() */
 
@@ -741,8 +819,10 @@ mbx_index   mailbox_index;     /* */
 msgAPI_tx   tx_msg;            /* */
 location packet_dest;          /* */
 mailbox_type current_mailbox;  /* */
-flag_type throwaway_flag_data; /* */
 data_union temp_data;          /* */
+flag_type throwaway_flag_data; /* */
+uint8_t temp_seq;              /* */
+int seq_size;                  /* */
 /*----------------------------------------------------------
 Init variables
 ----------------------------------------------------------*/
@@ -754,8 +834,16 @@ return_msg.destination = MODULE_NONE;
 message_full           = false;
 current_index          = 0;
 data_size              = 0;
+seq_size               = 0;
+temp_seq               = 0;
 mailbox_index          = mbx_index::MAILBOX_NONE;
 packet_dest            = MODULE_NONE;
+
+/*----------------------------------------------------------
+Add protocol header [id][version]
+----------------------------------------------------------*/
+return_msg.message[current_index++] = MSG_PROTOCOL_ID;
+return_msg.message[current_index++] = MAILBOX_PROTOCOL_VERSION;
  
 /*----------------------------------------------------------
 loop untill Tx queue is empty or tx_message is full
@@ -853,9 +941,12 @@ while( p_transmit_queue.size() > 0 && !message_full )
 	from loop
 
 	+1 (INDEX_BYTE_SIZE) is to include index byte in
-	addition to data
+	addition to data. data & ack messages also carry a
+	sequence byte (SEQ_BYTE_SIZE)
 	------------------------------------------------------*/
-	if( current_index + data_size + INDEX_BYTE_SIZE > MAX_MSG_LENGTH )
+	seq_size = ( tx_msg.r == msg_type::update ) ? 0 : SEQ_BYTE_SIZE;
+
+	if( current_index + data_size + INDEX_BYTE_SIZE + seq_size > MAX_MSG_LENGTH )
 		{
 		message_full    = true;
 		return_msg.size = current_index;
@@ -917,8 +1008,8 @@ while( p_transmit_queue.size() > 0 && !message_full )
 	
 
 	/*------------------------------------------------------
-	Format of data is   : [ index byte   ] [ data byte ]...
-	Format of ack is    : [ ack byte     ] [ index     ]
+	Format of data is   : [ index byte   ] [ seq ] [ data byte ]...
+	Format of ack is    : [ ack byte     ] [ index     ] [ seq ]
 	Format of update is : [ update byete ] [new round  ]
 
 	Add in index byte and update current_index
@@ -931,6 +1022,13 @@ while( p_transmit_queue.size() > 0 && !message_full )
 		case msg_type::ack:
 			return_msg.message[current_index++] = MSG_ACK_ID;
 			return_msg.message[current_index++] = static_cast<int>(mailbox_index);
+
+			/*----------------------------------------------
+			Ack the last accepted sequence number. This 
+			covers both new data and duplicates as a 
+			duplicate matches the last accepted number
+			----------------------------------------------*/
+			return_msg.message[current_index++] = p_link.ack_sent( static_cast<int>(mailbox_index) );
 			break;
 
 		/*--------------------------------------------------
@@ -946,9 +1044,17 @@ while( p_transmit_queue.size() > 0 && !message_full )
 			memset( &temp_data, 0, sizeof(data_union) );
 
 			/*----------------------------------------------
-			Access (mutex protected) and memcopy data 
+			Access (mutex protected) data & sequence byte
+			together so a concurrent update() cannot pair
+			new data with an old sequence number. Advances
+			the sequence number if the entry was written
 			----------------------------------------------*/
-			temp_data = this->access( mailbox_index, throwaway_flag_data );
+			temp_data = this->access_with_seq( mailbox_index, throwaway_flag_data, temp_seq, true, true );
+
+			/*----------------------------------------------
+			Add sequence byte and memcopy data 
+			----------------------------------------------*/
+			return_msg.message[current_index++] = temp_seq;
 			memcpy( &(return_msg.message[current_index]), &(temp_data), data_size ); 
 
 			/*----------------------------------------------
@@ -957,8 +1063,10 @@ while( p_transmit_queue.size() > 0 && !message_full )
 			current_index += data_size;
 
 			/*----------------------------------------------
-			Add data to ack queue
+			Add data to ack queue & record sequence number
+			awaiting ack
 			----------------------------------------------*/
+			p_link.sent( static_cast<int>(mailbox_index), temp_seq );
 			p_awaiting_ack[static_cast<int>(mailbox_index)] = true;
 
 			if( !p_ack_queue.push( mailbox_index ) )
@@ -1018,6 +1126,60 @@ void core::mailbox<M>::log_error( mailbox_error_types err )
 	p_errors |= err;
 }
 
+/*********************************************************************
+*
+*   PROCEDURE NAME:
+*       core::mailbox<M>::queue_tx()
+*
+*   DESCRIPTION:
+*       push a data/ack request to the transmit queue unless one is 
+*		already pending for that index. logs and returns false if
+*		queue is full
+*
+*   NOTE:
+*		pending flags are cleared by lora_pack_engine() once packed
+*
+*********************************************************************/
+template <int M>
+bool core::mailbox<M>::queue_tx
+	( 
+	msgAPI_tx msg /* transmit request */
+	)
+{
+/*----------------------------------------------------------
+Local variables
+----------------------------------------------------------*/
+bool tracked; /* data/ack request with a valid index */
+bool is_ack;  /* ack request                         */
+
+/*----------------------------------------------------------
+Initilize variables
+----------------------------------------------------------*/
+tracked = msg.r != msg_type::update && this->verify_index( static_cast<int>(msg.i) ) != mbx_index::MAILBOX_NONE;
+is_ack  = msg.r == msg_type::ack;
+
+/*----------------------------------------------------------
+Claim pending request, if already queued nothing to do
+----------------------------------------------------------*/
+if( tracked && !p_link.claim( static_cast<int>(msg.i), is_ack ) )
+	return true;
+
+/*----------------------------------------------------------
+Add to transmit queue, assert & release claim if full
+----------------------------------------------------------*/
+if( !p_transmit_queue.push( msg ) )
+	{
+	if( tracked )
+		p_link.release( static_cast<int>(msg.i), is_ack );
+
+	this->log_error(mailbox_error_types::QUEUE_FULL);
+	return false;
+	}
+
+return true;
+
+} /* core::mailbox<M>::queue_tx() */
+
 
 
 /*********************************************************************
@@ -1073,6 +1235,7 @@ Update mailbox while protected
 	if( user_mode )
 		{
 		p_mailbox_ref[global_mbx_indx].flag = flag_type::TRANSMIT_FLAG;
+
 		}
 	else
 		{
@@ -1110,6 +1273,45 @@ data_union core::mailbox<M>::access
 /*----------------------------------------------------------
 Variables
 ----------------------------------------------------------*/
+uint8_t throwaway_seq; /* tx sequence byte, unused */
+
+/*----------------------------------------------------------
+Access data, flag handling is shared with the tx engine
+----------------------------------------------------------*/
+return this->access_with_seq( global_mbx_indx, current_flag, throwaway_seq, clear_flag, false );
+
+} /* core::mailbox::access() */
+
+/*********************************************************************
+*
+*   PROCEDURE NAME:
+*       core::mailbox::access_with_seq()
+*
+*   DESCRIPTION:
+*       This is a private function that accesses mailbox data along
+*		with its tx sequence byte. Data, flag & sequence byte are
+*		handled under a single lock
+*
+*   NOTE:
+*		when transmitting (advance_seq) the sequence number advances
+*		once if the entry has been written since it was last packed
+*		(TRANSMIT_FLAG), no matter how many writes occurred. This
+*		keeps the sequence number within SEQ_WINDOW of the receiver
+*
+*********************************************************************/
+template <int M>
+data_union core::mailbox<M>::access_with_seq
+	(
+	mbx_index global_mbx_indx, /* mailbox index                  */
+	flag_type& current_flag,   /* returns current flag data      */
+	uint8_t&  seq_byte,        /* returns tx sequence byte       */
+	bool      clear_flag,      /* default yes                    */
+	bool      advance_seq      /* advance seq if written         */
+	)
+{ 
+/*----------------------------------------------------------
+Variables
+----------------------------------------------------------*/
 data_union rtn_data;
 
 /*----------------------------------------------------------
@@ -1117,6 +1319,7 @@ Initize Variables
 ----------------------------------------------------------*/
 rtn_data.uint32 = 0xFFFF; //need a better way of determining if flag or not
 current_flag     = flag_type::NO_FLAG;
+seq_byte         = 0;
 
 /*----------------------------------------------------------
 Verify passed in index
@@ -1132,13 +1335,18 @@ Aquire reference to data
 mailbox_type& current_mbx = p_mailbox_ref[ static_cast<int>(global_mbx_indx) ];
 
 /*----------------------------------------------------------
-Handle and aquire flag data while protected
+Handle and aquire flag & sequence data while protected
 ----------------------------------------------------------*/
 	{
 	utl::mutex_lock lock( p_mailbox_protection );
 
 	current_flag = current_mbx.flag;
 
+	if( advance_seq && current_flag == flag_type::TRANSMIT_FLAG )
+		p_link.advance( static_cast<int>(global_mbx_indx) );
+
+	seq_byte     = p_link.tx_seq( static_cast<int>(global_mbx_indx) );
+
 	if( clear_flag )
 		current_mbx.flag = flag_type::NO_FLAG;
 
@@ -1148,7 +1356,7 @@ Handle and aquire flag data while protected
 	return current_mbx.data;
 	}
 
-} /* core::mailbox::access() */
+} /* core::mailbox::access_with_seq() */
 
 /*********************************************************************
 *
@@ -1208,6 +1416,27 @@ if( !p_watchdog_pet )
 	}
 } /* core::mailbox::watchdog() */
 
+/*********************************************************************
+*
+*   PROCEDURE NAME:
+*       core::mailbox::sequence_stats()
+*
+*   DESCRIPTION:
+*       returns counters of data frames & acks dropped due to sequence
+*		numbers
+*
+*   NOTE:
+*
+*********************************************************************/
+template <int M>
+mailbox_seq_stats core::mailbox<M>::sequence_stats
+	( 
+	void 
+	)
+{
+return p_link.stats();
+} /* core::mailbox::sequence_stats() */
+
 /*********************************************************************
 *
 *   PROCEDURE NAME:
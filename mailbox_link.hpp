@@ -0,0 +1,120 @@
+#ifndef MAILBOX_LINK_HPP
+#define MAILBOX_LINK_HPP
+/*********************************************************************
+*
+*   HEADER:
+*       header file for mailbox link state (per entry sequence numbers
+*       and pending transmit requests)
+*
+*   Copyright 2025 Nate Lenze
+*
+**********************************************************************/
+/*--------------------------------------------------------------------
+                              INCLUDES
+--------------------------------------------------------------------*/
+#include <array>
+#include <stdint.h>
+
+/*--------------------------------------------------------------------
+                          GLOBAL NAMESPACES
+--------------------------------------------------------------------*/
+
+/*--------------------------------------------------------------------
+                          LITERAL CONSTANTS
+--------------------------------------------------------------------*/
+#define SEQ_MASK                ( 0x7F ) /* sequence number bits   */
+#define SEQ_RESET_FLAG          ( 0x80 ) /* set by a sender that has
+                                            not been acked since
+                                            startup                */
+#define SEQ_WINDOW              ( 0x40 ) /* sequence numbers less
+                                            than this far ahead are
+                                            considered newer       */
+#define STALE_RESYNC_LIMIT      ( 3    ) /* consecutive stale frame
+                                            that is accepted to 
+                                            resync to the sender   */
+
+/*--------------------------------------------------------------------
+                         STRUCTS/TYPES/ENUMS
+--------------------------------------------------------------------*/
+enum struct seq_status /* rx sequence number classification         */
+    {
+    fresh,             /* new data, process & ack                   */
+    duplicate,         /* retransmit of accepted data, re-ack only  */
+    stale,             /* older than accepted data, drop            */
+    num_seq_status     /* number of sequence statuses               */
+    };
+
+struct mailbox_seq_stats     /* sequence number statistics          */
+    {
+    uint32_t duplicates_dropped; /* retransmitted data frames that
+                                    were re-acked but not processed */
+    uint32_t stale_dropped;      /* older data frames dropped       */
+    uint32_t stale_acks;         /* acks for a superseded sequence
+                                    number                          */
+    uint32_t resyncs;            /* times the receiver resynced to a
+                                    sender (reset flag or repeated
+                                    stale frames)                   */
+    };
+
+/*--------------------------------------------------------------------
+                           MEMORY CONSTANTS
+--------------------------------------------------------------------*/
+
+/*--------------------------------------------------------------------
+                              VARIABLES
+--------------------------------------------------------------------*/
+
+/*--------------------------------------------------------------------
+                                MACROS
+--------------------------------------------------------------------*/
+
+/*--------------------------------------------------------------------
+                              PROCEDURES
+--------------------------------------------------------------------*/
+
+/*--------------------------------------------------------------------
+                          MAILBOX LINK CLASS
+--------------------------------------------------------------------*/
+namespace core {
+
+template<int M>
+class mailbox_link
+    {
+    public:
+        mailbox_link( uint8_t seed );                    /* constructor                */
+
+        void advance( int idx );                         /* advance tx sequence        */
+        uint8_t tx_seq( int idx );                       /* tx sequence byte           */
+        void sent( int idx, uint8_t seq_byte );          /* record seq awaiting ack    */
+        bool ack( int idx, uint8_t seq );                /* verify ack sequence        */
+
+        seq_status receive( int idx, uint8_t seq_byte, bool changed ); /* classify rx seq byte */
+        uint8_t rx_seq( int idx );                       /* last accepted rx sequence  */
+        uint8_t ack_sent( int idx );                     /* record ack, return seq     */
+
+        bool claim( int idx, bool is_ack );              /* claim pending tx request   */
+        void release( int idx, bool is_ack );            /* release pending tx request */
+
+        mailbox_seq_stats stats( void );                 /* sequence statistics        */
+
+    private:
+        std::array<uint8_t, M> p_tx_seq;       /* tx sequence number per entry   */
+        std::array<uint8_t, M> p_inflight_seq; /* tx sequence awaiting ack       */
+        std::array<bool, M> p_tx_synced;       /* tx acked since startup         */
+        std::array<uint8_t, M> p_rx_seq;       /* last accepted rx sequence      */
+        std::array<bool, M> p_rx_synced;       /* rx accepted since startup      */
+        std::array<bool, M> p_rx_reset;        /* last accepted had reset flag   */
+        std::array<uint8_t, M> p_stale_cntr;   /* consecutive stale frames       */
+        std::array<bool, M> p_data_pending;    /* data queued for transmit       */
+        std::array<bool, M> p_ack_pending;     /* ack queued for transmit        */
+        mailbox_seq_stats p_stats;             /* sequence number statistics     */
+    };
+
+} /* core namespace */
+
+/*--------------------------------------------------------------------
+                        TEMPLATE INITILIZATION
+--------------------------------------------------------------------*/
+#include "mailbox_link.tpp"
+
+#endif
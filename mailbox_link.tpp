@@ -0,0 +1,385 @@
+/*********************************************************************
+*
+*   NAME:
+*       mailbox_link.tpp
+*
+*   DESCRIPTION:
+*       Per entry link state for mailbox API. Tracks sequence numbers
+*       for duplicate suppression and pending transmit requests.
+*
+*       Sequence bytes are formatted as [reset flag][7bit sequence].
+*       A sender sets the reset flag until its first ack after startup
+*       so receivers know to resync rather than compare against
+*       sequence numbers from a previous run.
+*
+*   Copyright 2025 Nate Lenze
+*
+*********************************************************************/
+
+/*--------------------------------------------------------------------
+                              INCLUDES
+--------------------------------------------------------------------*/
+#include "mailbox_link.hpp"
+
+#include <string.h>
+
+/*--------------------------------------------------------------------
+                          GLOBAL NAMESPACES
+--------------------------------------------------------------------*/
+
+/*--------------------------------------------------------------------
+                          LITERAL CONSTANTS
+--------------------------------------------------------------------*/
+
+/*--------------------------------------------------------------------
+                                TYPES
+--------------------------------------------------------------------*/
+
+/*--------------------------------------------------------------------
+                           MEMORY CONSTANTS
+--------------------------------------------------------------------*/
+
+/*--------------------------------------------------------------------
+                              VARIABLES
+--------------------------------------------------------------------*/
+
+/*--------------------------------------------------------------------
+                                MACROS
+--------------------------------------------------------------------*/
+
+/*--------------------------------------------------------------------
+                              PROCEDURES
+--------------------------------------------------------------------*/
+/*********************************************************************
+*
+*   PROCEDURE NAME:
+*       core::mailbox_link::mailbox_link (constructor)
+*
+*   DESCRIPTION:
+*       mailbox link constructor. All entries start unsynced with
+*       nothing pending
+*
+*   NOTE:
+*       seed should differ per boot (e.g. random) so reset flagged
+*       frames from consecutive boots do not share sequence numbers
+*
+*********************************************************************/
+template <int M>
+core::mailbox_link<M>::mailbox_link
+	(
+	uint8_t seed /* initial tx sequence number */
+	)
+{
+memset( &p_tx_seq, seed & SEQ_MASK, sizeof(uint8_t)*M );
+memset( &p_inflight_seq, 0, sizeof(uint8_t)*M );
+memset( &p_tx_synced, 0, sizeof(bool)*M );
+memset( &p_rx_seq, 0, sizeof(uint8_t)*M );
+memset( &p_rx_synced, 0, sizeof(bool)*M );
+memset( &p_rx_reset, 0, sizeof(bool)*M );
+memset( &p_stale_cntr, 0, sizeof(uint8_t)*M );
+memset( &p_data_pending, 0, sizeof(bool)*M );
+memset( &p_ack_pending, 0, sizeof(bool)*M );
+memset( &p_stats, 0, sizeof(mailbox_seq_stats) );
+
+} /* core::mailbox_link<M>::mailbox_link() */
+
+/*********************************************************************
+*
+*   PROCEDURE NAME:
+*       core::mailbox_link::advance()
+*
+*   DESCRIPTION:
+*       advance tx sequence number for a new value. rolls over within
+*       SEQ_MASK
+*
+*********************************************************************/
+template <int M>
+void core::mailbox_link<M>::advance
+	(
+	int idx /* mailbox index */
+	)
+{
+p_tx_seq[idx] = ( p_tx_seq[idx] + 1 ) & SEQ_MASK;
+
+} /* core::mailbox_link<M>::advance() */
+
+/*********************************************************************
+*
+*   PROCEDURE NAME:
+*       core::mailbox_link::tx_seq()
+*
+*   DESCRIPTION:
+*       returns sequence byte to transmit. includes SEQ_RESET_FLAG
+*       until the entry has been acked since startup
+*
+*********************************************************************/
+template <int M>
+uint8_t core::mailbox_link<M>::tx_seq
+	(
+	int idx /* mailbox index */
+	)
+{
+if( p_tx_synced[idx] )
+	return p_tx_seq[idx];
+
+return p_tx_seq[idx] | SEQ_RESET_FLAG;
+
+} /* core::mailbox_link<M>::tx_seq() */
+
+/*********************************************************************
+*
+*   PROCEDURE NAME:
+*       core::mailbox_link::sent()
+*
+*   DESCRIPTION:
+*       record the sequence number packed for an entry so it can be
+*       matched against its ack. clears pending data request
+*
+*********************************************************************/
+template <int M>
+void core::mailbox_link<M>::sent
+	(
+	int idx,         /* mailbox index              */
+	uint8_t seq_byte /* sequence byte transmitted  */
+	)
+{
+p_inflight_seq[idx] = seq_byte & SEQ_MASK;
+p_data_pending[idx] = false;
+
+} /* core::mailbox_link<M>::sent() */
+
+/*********************************************************************
+*
+*   PROCEDURE NAME:
+*       core::mailbox_link::ack()
+*
+*   DESCRIPTION:
+*       returns true if an ack matches the sequence number in flight,
+*       marking the entry as synced. An ack for a superseded sequence
+*       number is counted and returns false
+*
+*********************************************************************/
+template <int M>
+bool core::mailbox_link<M>::ack
+	(
+	int idx,    /* mailbox index         */
+	uint8_t seq /* acked sequence number */
+	)
+{
+if( ( seq & SEQ_MASK ) != p_inflight_seq[idx] )
+	{
+	p_stats.stale_acks++;
+	return false;
+	}
+
+p_tx_synced[idx] = true;
+return true;
+
+} /* core::mailbox_link<M>::ack() */
+
+/*********************************************************************
+*
+*   PROCEDURE NAME:
+*       core::mailbox_link::receive()
+*
+*   DESCRIPTION:
+*       classify a received sequence byte against the last accepted
+*       sequence number for an entry & update statistics
+*
+*   NOTE:
+*       - first frame after startup is allways accepted
+*       - reset flagged frames are accepted unless they repeat the
+*         last accepted reset flagged frame with unchanged data. A
+*         sender that reboots again before being acked may reuse a
+*         sequence number, changed data is never dropped
+*       - otherwise numbers less than SEQ_WINDOW ahead are newer,
+*         equal is a duplicate and anything else is stale. The
+*         STALE_RESYNC_LIMIT'th consecutive stale frame is accepted
+*         so a sender is never ignored indefinitely
+*
+*********************************************************************/
+template <int M>
+seq_status core::mailbox_link<M>::receive
+	(
+	int idx,          /* mailbox index                      */
+	uint8_t seq_byte, /* received sequence byte             */
+	bool changed      /* data differs from accepted data    */
+	)
+{
+/*----------------------------------------------------------
+Local variables
+----------------------------------------------------------*/
+uint8_t seq;   /* received sequence number         */
+bool    reset; /* received frame has reset flag    */
+uint8_t delta; /* distance ahead of last accepted  */
+
+/*----------------------------------------------------------
+Initilize variables
+----------------------------------------------------------*/
+seq   = seq_byte & SEQ_MASK;
+reset = ( seq_byte & SEQ_RESET_FLAG ) != 0;
+delta = ( seq - p_rx_seq[idx] ) & SEQ_MASK;
+
+/*----------------------------------------------------------
+Classify frame
+----------------------------------------------------------*/
+if( p_rx_synced[idx] )
+	{
+	if( reset )
+		{
+		/*--------------------------------------------------
+		Repeat of accepted reset frame is a duplicate, any
+		other reset frame means the sender has rebooted
+		--------------------------------------------------*/
+		if( p_rx_reset[idx] && delta == 0 && !changed )
+			{
+			p_stale_cntr[idx] = 0;
+			p_stats.duplicates_dropped++;
+			return seq_status::duplicate;
+			}
+
+		if( !p_rx_reset[idx] )
+			p_stats.resyncs++;
+		}
+	else if( delta == 0 )
+		{
+		p_rx_reset[idx]   = false;
+		p_stale_cntr[idx] = 0;
+		p_stats.duplicates_dropped++;
+		return seq_status::duplicate;
+		}
+	else if( delta >= SEQ_WINDOW )
+		{
+		/*--------------------------------------------------
+		Drop stale frame unless it keeps repeating
+		--------------------------------------------------*/
+		if( ++p_stale_cntr[idx] < STALE_RESYNC_LIMIT )
+			{
+			p_stats.stale_dropped++;
+			return seq_status::stale;
+			}
+
+		p_stats.resyncs++;
+		}
+	}
+
+/*----------------------------------------------------------
+Accept frame
+----------------------------------------------------------*/
+p_rx_seq[idx]     = seq;
+p_rx_synced[idx]  = true;
+p_rx_reset[idx]   = reset;
+p_stale_cntr[idx] = 0;
+
+return seq_status::fresh;
+
+} /* core::mailbox_link<M>::receive() */
+
+/*********************************************************************
+*
+*   PROCEDURE NAME:
+*       core::mailbox_link::rx_seq()
+*
+*   DESCRIPTION:
+*       returns last accepted rx sequence number
+*
+*********************************************************************/
+template <int M>
+uint8_t core::mailbox_link<M>::rx_seq
+	(
+	int idx /* mailbox index */
+	)
+{
+return p_rx_seq[idx];
+
+} /* core::mailbox_link<M>::rx_seq() */
+
+/*********************************************************************
+*
+*   PROCEDURE NAME:
+*       core::mailbox_link::ack_sent()
+*
+*   DESCRIPTION:
+*       record an ack packed for an entry. clears pending ack request
+*       and returns the sequence number to echo (last accepted)
+*
+*********************************************************************/
+template <int M>
+uint8_t core::mailbox_link<M>::ack_sent
+	(
+	int idx /* mailbox index */
+	)
+{
+p_ack_pending[idx] = false;
+return p_rx_seq[idx];
+
+} /* core::mailbox_link<M>::ack_sent() */
+
+/*********************************************************************
+*
+*   PROCEDURE NAME:
+*       core::mailbox_link::claim()
+*
+*   DESCRIPTION:
+*       claim a pending data/ack request for an entry. returns false
+*       if one is already pending
+*
+*********************************************************************/
+template <int M>
+bool core::mailbox_link<M>::claim
+	(
+	int idx,    /* mailbox index        */
+	bool is_ack /* ack or data request  */
+	)
+{
+bool& pending = is_ack ? p_ack_pending[idx] : p_data_pending[idx];
+
+if( pending )
+	return false;
+
+pending = true;
+return true;
+
+} /* core::mailbox_link<M>::claim() */
+
+/*********************************************************************
+*
+*   PROCEDURE NAME:
+*       core::mailbox_link::release()
+*
+*   DESCRIPTION:
+*       release a pending data/ack request without transmitting it
+*
+*********************************************************************/
+template <int M>
+void core::mailbox_link<M>::release
+	(
+	int idx,    /* mailbox index        */
+	bool is_ack /* ack or data request  */
+	)
+{
+if( is_ack )
+	p_ack_pending[idx] = false;
+else
+	p_data_pending[idx] = false;
+
+} /* core::mailbox_link<M>::release() */
+
+/*********************************************************************
+*
+*   PROCEDURE NAME:
+*       core::mailbox_link::stats()
+*
+*   DESCRIPTION:
+*       returns sequence number statistics
+*
+*********************************************************************/
+template <int M>
+mailbox_seq_stats core::mailbox_link<M>::stats
+	(
+	void
+	)
+{
+return p_stats;
+
+} /* core::mailbox_link<M>::stats() */
@@ -52,7 +52,8 @@ enum struct mbx_index : uint8_t
     MAILBOX_NONE,          /* Mailbox None      */
     
     RESERVED_1 = 0xFF,     /* ACK ID            */
-    RESERVED_2 = 0xFE      /* Round Update ID   */
+    RESERVED_2 = 0xFE,     /* Round Update ID   */
+    RESERVED_3 = 0xFD      /* Protocol ID       */
     
     };
 
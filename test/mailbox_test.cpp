@@ -32,6 +32,13 @@
 #define NUM_TX_TEST_CASES (5)
 #define NUM_RX_TEST_CASES (5)
 
+#define TEST_CMD_DUPLICATE_CNT  (25) /* report duplicates_dropped      */
+#define TEST_CMD_ASYNC_FLAG_CNT (26) /* report ASYNC_TX_FROM_RPI_MSG
+                                        RECEIVE_FLAG count             */
+#define TEST_CMD_SELF_TEST      (27) /* report link self test result,
+                                        1 pass 0 fail                  */
+#define TEST_LINK_SIZE          (4)  /* mailbox_link self test size    */
+
 /*--------------------------------------------------------------------
                                 TYPES
 --------------------------------------------------------------------*/
@@ -62,6 +69,13 @@ const std::unordered_map< uint32_t, std::pair<mbx_index, data_union> > tx_test_c
 { 14, { mbx_index::RND_5_TX_FROM_RPI_MSG, {.uint32 = 15}    } }
 };
 
+static uint32_t s_async_flag_cntr = 0; /* RECEIVE_FLAG count for 
+                                          ASYNC_TX_FROM_RPI_MSG       */
+static bool s_self_test_run = false;   /* link self test has run      */
+static bool s_self_test_pass = false;  /* link self test result       */
+static uint32_t s_last_test_cmd = 0;   /* last sequence test command
+                                          reported                    */
+
 
 /*--------------------------------------------------------------------
                                 MACROS
@@ -71,10 +85,34 @@ const std::unordered_map< uint32_t, std::pair<mbx_index, data_union> > tx_test_c
                                 EXTERNS
 --------------------------------------------------------------------*/
 extern core::mailbox< (size_t)mbx_index::NUM_MAILBOX > Mailbox;
+extern core::console Console;
 
 /*--------------------------------------------------------------------
                               PROCEDURES
 --------------------------------------------------------------------*/
+/*********************************************************************
+*
+*   PROCEDURE NAME:
+*       check_case()
+*
+*   DESCRIPTION:
+*       asserts with test name if test case failed. returns result
+*
+*********************************************************************/
+static bool check_case
+    ( 
+    bool        result, /* test case result */
+    const char* name    /* test case name   */
+    )
+{
+if( !result )
+    {
+    Console.add_assert( std::string( "mailbox link self test failed: " ) + name );
+    }
+
+return result;
+}
+
 /*********************************************************************
 *
 *   PROCEDURE NAME:
@@ -104,6 +142,20 @@ Initialize variables
 ----------------------------------------------------------*/
 return_value.uint32 = 0xFF;
 
+/*----------------------------------------------------------
+Run link self test once
+----------------------------------------------------------*/
+if( !s_self_test_run )
+    {
+    s_self_test_pass = link_self_test();
+    s_self_test_run  = true;
+
+    if( !s_self_test_pass )
+        {
+        Console.add_assert( "mailbox link self test: FAIL" );
+        }
+    }
+
 /*----------------------------------------------------------
 TX (from raspberry pi) test cases
 ----------------------------------------------------------*/
@@ -120,6 +172,16 @@ while( tx_itr != tx_test_cases.end() )
     ------------------------------------------------------*/
     if( temp_flag != flag_type::NO_FLAG )
         {
+        /*--------------------------------------------------
+        Count async receptions. A retransmit after a lost
+        ack must not re-flag, so this should match the
+        number of values written by the raspberry pi
+        --------------------------------------------------*/
+        if( (tx_itr->second).first == mbx_index::ASYNC_TX_FROM_RPI_MSG )
+            {
+            s_async_flag_cntr++;
+            }
+
         /*--------------------------------------------------
         If data is expected, update output index
         --------------------------------------------------*/
@@ -164,4 +226,206 @@ while( rx_itr != rx_test_cases.end() )
     rx_itr++;
     }
 
-}
\ No newline at end of file
+/*----------------------------------------------------------
+Sequence number test cases, report result on 
+INT_RX_FROM_RPI_MSG. Only written once per command change so
+reporting does not itself generate traffic every call, re-send
+the command (after another) to refresh
+----------------------------------------------------------*/
+temp_data = Mailbox[mbx_index::TEST_TX_FROM_RPI_MSG];
+
+if( static_cast<uint32_t>(temp_data.uint32) != s_last_test_cmd )
+    {
+    s_last_test_cmd = temp_data.uint32;
+
+    switch( temp_data.uint32 )
+        {
+        case TEST_CMD_DUPLICATE_CNT:
+            return_value.uint32 = Mailbox.sequence_stats().duplicates_dropped;
+            Mailbox[mbx_index::INT_RX_FROM_RPI_MSG] = return_value;
+            break;
+
+        case TEST_CMD_ASYNC_FLAG_CNT:
+            return_value.uint32 = s_async_flag_cntr;
+            Mailbox[mbx_index::INT_RX_FROM_RPI_MSG] = return_value;
+            break;
+
+        case TEST_CMD_SELF_TEST:
+            return_value.uint32 = s_self_test_pass ? 1 : 0;
+            Mailbox[mbx_index::INT_RX_FROM_RPI_MSG] = return_value;
+            break;
+
+        default:
+            break;
+        }
+    }
+
+}
+
+/*********************************************************************
+*
+*   PROCEDURE NAME:
+*       link_self_test()
+*
+*   DESCRIPTION:
+*       exercises core::mailbox_link sequence & pending rules without
+*       the radio. asserts on each failed case, returns true if all
+*       cases pass
+*
+*********************************************************************/
+bool mailbox_testing::link_self_test
+    ( 
+    void
+    )
+{
+/*----------------------------------------------------------
+Local variables
+----------------------------------------------------------*/
+int  i;
+bool pass;
+
+/*----------------------------------------------------------
+Initialize variables
+----------------------------------------------------------*/
+pass = true;
+
+/*----------------------------------------------------------
+Receiver: first frame after startup is accepted, repeat is
+a duplicate
+----------------------------------------------------------*/
+    {
+    core::mailbox_link<TEST_LINK_SIZE> link( 0 );
+
+    pass &= check_case( link.receive( 0, 5, false ) == seq_status::fresh,     "first frame fresh"   );
+    pass &= check_case( link.receive( 0, 5, false ) == seq_status::duplicate, "repeat is duplicate" );
+    pass &= check_case( link.stats().duplicates_dropped == 1,          "duplicate counted"   );
+    pass &= check_case( link.rx_seq( 0 ) == 5,                         "rx seq"              );
+    pass &= check_case( link.ack_sent( 0 ) == 5,                       "ack echoes rx seq"   );
+    }
+
+/*----------------------------------------------------------
+Receiver: window edge, 63 ahead is fresh, 64 apart is stale
+----------------------------------------------------------*/
+    {
+    core::mailbox_link<TEST_LINK_SIZE> link( 0 );
+
+    link.receive( 0, 5, false );
+    pass &= check_case( link.receive( 0, 5 + 63, false ) == seq_status::fresh,                 "63 ahead fresh" );
+    pass &= check_case( link.receive( 0, ( 68 + 64 ) & SEQ_MASK, false ) == seq_status::stale, "64 apart stale" );
+    pass &= check_case( link.stats().stale_dropped == 1,                                 "stale counted"  );
+    }
+
+/*----------------------------------------------------------
+Receiver & sender: rollover from 127 to 0
+----------------------------------------------------------*/
+    {
+    core::mailbox_link<TEST_LINK_SIZE> link( 0 );
+
+    link.receive( 0, 127, false );
+    pass &= check_case( link.receive( 0, 0, false ) == seq_status::fresh, "rx rollover fresh" );
+    pass &= check_case( link.rx_seq( 0 ) == 0,                     "rx rollover seq"   );
+
+    for( i = 0; i < 127; i++ )
+        {
+        link.advance( 1 );
+        }
+    pass &= check_case( link.tx_seq( 1 ) == ( 127 | SEQ_RESET_FLAG ), "tx seq 127" );
+    link.advance( 1 );
+    pass &= check_case( link.tx_seq( 1 ) == ( 0 | SEQ_RESET_FLAG ),   "tx rollover" );
+    }
+
+/*----------------------------------------------------------
+Receiver: rebooted sender (reset flag) resyncs once, repeat
+of the reset frame is a duplicate
+----------------------------------------------------------*/
+    {
+    core::mailbox_link<TEST_LINK_SIZE> link( 0 );
+
+    link.receive( 0, 50, false );
+    pass &= check_case( link.receive( 0, 1 | SEQ_RESET_FLAG, false ) == seq_status::fresh,     "reset resync"      );
+    pass &= check_case( link.stats().resyncs == 1,                                       "resync counted"    );
+    pass &= check_case( link.receive( 0, 1 | SEQ_RESET_FLAG, false ) == seq_status::duplicate, "reset duplicate"   );
+    pass &= check_case( link.receive( 0, 2 | SEQ_RESET_FLAG, false ) == seq_status::fresh,     "reset next fresh"  );
+    pass &= check_case( link.receive( 0, 2, false ) == seq_status::duplicate,                  "synced duplicate"  );
+    pass &= check_case( link.receive( 0, 3, false ) == seq_status::fresh,                      "synced fresh"      );
+    }
+
+/*----------------------------------------------------------
+Receiver: sender reboots again before being acked & reuses
+its reset frame sequence number. Changed data is fresh
+----------------------------------------------------------*/
+    {
+    core::mailbox_link<TEST_LINK_SIZE> link( 0 );
+
+    link.receive( 0, 1 | SEQ_RESET_FLAG, true );
+    pass &= check_case( link.receive( 0, 1 | SEQ_RESET_FLAG, true ) == seq_status::fresh,      "reboot reuse changed"   );
+    pass &= check_case( link.receive( 0, 1 | SEQ_RESET_FLAG, false ) == seq_status::duplicate, "reboot reuse unchanged" );
+    }
+
+/*----------------------------------------------------------
+Sender: seed sets initial sequence number per boot
+----------------------------------------------------------*/
+    {
+    core::mailbox_link<TEST_LINK_SIZE> link( 0xC5 );
+
+    pass &= check_case( link.tx_seq( 0 ) == ( ( 0xC5 & SEQ_MASK ) | SEQ_RESET_FLAG ), "seeded tx seq" );
+    }
+
+/*----------------------------------------------------------
+Receiver: repeated stale frames resync after
+STALE_RESYNC_LIMIT
+----------------------------------------------------------*/
+    {
+    core::mailbox_link<TEST_LINK_SIZE> link( 0 );
+
+    link.receive( 0, 50, false );
+    for( i = 1; i < STALE_RESYNC_LIMIT; i++ )
+        {
+        pass &= check_case( link.receive( 0, 10, false ) == seq_status::stale, "stale dropped" );
+        }
+    pass &= check_case( link.receive( 0, 10, false ) == seq_status::fresh, "stale resync"     );
+    pass &= check_case( link.rx_seq( 0 ) == 10,                     "stale resync seq" );
+    }
+
+/*----------------------------------------------------------
+Sender: mismatched ack keeps entry pending, matching ack
+syncs and clears reset flag
+----------------------------------------------------------*/
+    {
+    core::mailbox_link<TEST_LINK_SIZE> link( 0 );
+
+    link.advance( 0 );
+    link.sent( 0, link.tx_seq( 0 ) );
+    pass &= check_case( !link.ack( 0, 0 ),                 "stale ack rejected" );
+    pass &= check_case( link.stats().stale_acks == 1,      "stale ack counted"  );
+    pass &= check_case( link.tx_seq( 0 ) & SEQ_RESET_FLAG, "unsynced reset flag" );
+    pass &= check_case( link.ack( 0, 1 ),                  "ack accepted"       );
+    pass &= check_case( link.tx_seq( 0 ) == 1,             "synced no reset"    );
+    }
+
+/*----------------------------------------------------------
+Pending: data & ack requests are deduplicated separately and
+released once packed
+----------------------------------------------------------*/
+    {
+    core::mailbox_link<TEST_LINK_SIZE> link( 0 );
+
+    pass &= check_case( link.claim( 0, false ),  "data claim"         );
+    pass &= check_case( !link.claim( 0, false ), "data deduplicated"  );
+    pass &= check_case( link.claim( 0, true ),   "ack claim"          );
+    pass &= check_case( !link.claim( 0, true ),  "ack deduplicated"   );
+    pass &= check_case( link.claim( 1, false ),  "other index claim"  );
+
+    link.sent( 0, 0 );
+    pass &= check_case( link.claim( 0, false ),  "data released"      );
+    link.rx_seq( 0 );
+    pass &= check_case( !link.claim( 0, true ),  "rx seq keeps ack"   );
+    link.ack_sent( 0 );
+    pass &= check_case( link.claim( 0, true ),   "ack released"       );
+    link.release( 1, false );
+    pass &= check_case( link.claim( 1, false ),  "release"            );
+    }
+
+return pass;
+
+} /* mailbox_testing::link_self_test() */
\ No newline at end of file
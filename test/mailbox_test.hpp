@@ -49,5 +49,10 @@ void run
     void
     );
 
+bool link_self_test
+    ( 
+    void
+    );
+
 } /* namespace mailbox_testing*/
 #endif
\ No newline at end of file